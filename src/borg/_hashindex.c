@@ -102,6 +102,10 @@ static void *hashindex_next_key(HashIndex *index, const void *key);
 /* Private API */
 static void hashindex_free(HashIndex *index);
 
+/* resize statistics, summed over all indexes of this process */
+static uint64_t hashindex_resize_count = 0;
+static uint64_t hashindex_resize_entries = 0;
+
 static int
 hashindex_index(HashIndex *index, const void *key)
 {
@@ -162,6 +166,8 @@ hashindex_resize(HashIndex *index, int capacity)
     index->lower_limit = new->lower_limit;
     index->upper_limit = new->upper_limit;
     free(new);
+    hashindex_resize_count += 1;
+    hashindex_resize_entries += index->num_entries;
     return 1;
 }
 
@@ -40,6 +40,7 @@ from .key import key_factory
 from .platform import acl_get, acl_set, set_flags, get_flags, swidth
 from .remote import cache_if_remote
 from .repository import Repository
+from .timings import timings
 
 has_lchmod = hasattr(os, 'lchmod')
 
@@ -254,6 +255,7 @@ class Archive:
         self.manifest = manifest
         self.hard_links = {}
         self.stats = Statistics()
+        self.items_stats = Statistics()
         self.show_progress = progress
         self.name = name
         self.checkpoint_interval = checkpoint_interval
@@ -357,6 +359,11 @@ Number of files: {0.stats.nfiles}'''.format(
     def add_item(self, item, show_progress=True):
         if show_progress and self.show_progress:
             self.stats.show_progress(item=item, dt=0.2)
+        if 'chunks' in item:
+            # count like calc_stats() does, so save() can store the result in the archive metadata
+            self.items_stats.nfiles += 1
+            for _, size, csize in item.chunks:
+                self.items_stats.update(size, csize, False)
         self.items_buffer.add(item)
 
     def write_checkpoint(self):
@@ -377,6 +384,12 @@ Number of files: {0.stats.nfiles}'''.format(
             self.end = timestamp
             start = timestamp
             end = timestamp  # we only have 1 value
+        # the archive metadata chunk itself is not included, its size is not known yet
+        size, csize = self.items_stats.osize, self.items_stats.csize
+        for id in self.items_buffer.chunks:
+            _, chunk_size, chunk_csize = self.cache.chunks[id]
+            size += chunk_size
+            csize += chunk_csize
         metadata = {
             'version': 1,
             'name': name,
@@ -388,6 +401,9 @@ Number of files: {0.stats.nfiles}'''.format(
             'time': start.isoformat(),
             'time_end': end.isoformat(),
             'chunker_params': self.chunker_params,
+            'nfiles': self.items_stats.nfiles,
+            'size': size,
+            'csize': csize,
         }
         metadata.update(additional_metadata or {})
         metadata = ArchiveItem(metadata)
@@ -400,6 +416,22 @@ Number of files: {0.stats.nfiles}'''.format(
         self.cache.commit()
 
     def calc_stats(self, cache):
+        if 'nfiles' in self.metadata:
+            # only the deduplicated size changes after save(), and we can get it from the archive's
+            # chunk index in the cache (if we have it) without reading all the items.
+            archive_index = cache.archive_chunk_index(self.id)
+            if archive_index is not None:
+                _, size, csize = cache.chunks[self.id]
+                stats = Statistics()
+                stats.nfiles = self.metadata.nfiles
+                stats.osize = self.metadata.size + size
+                stats.csize = self.metadata.csize + csize
+                for id, (count, _, chunk_csize) in archive_index.iteritems():
+                    # unique to this archive if all references to the chunk are from this archive
+                    if cache.chunks[id].refcount == count:
+                        stats.usize += chunk_csize
+                return stats
+
         def add(id):
             count, size, csize = cache.chunks[id]
             stats.update(size, csize, count == 1)
@@ -507,7 +539,8 @@ Number of files: {0.stats.nfiles}'''.format(
                             # all-zero chunk: create a hole in a sparse file
                             fd.seek(len(data), 1)
                         else:
-                            fd.write(data)
+                            with timings.timer('extract_write', len(data)):
+                                fd.write(data)
                 with backup_io():
                     pos = fd.tell()
                     fd.truncate(pos)
@@ -761,8 +794,10 @@ Number of files: {0.stats.nfiles}'''.format(
         item.chunks = []
         from_chunk = 0
         part_number = 1
-        for data in backup_io_iter(self.chunker.chunkify(fd, fh)):
-            item.chunks.append(cache.add_chunk(self.key.id_hash(data), Chunk(data, **chunk_kw), stats))
+        for data in timings.timed_iter('chunker', backup_io_iter(self.chunker.chunkify(fd, fh))):
+            with timings.timer('id_hash', len(data)):
+                id_ = self.key.id_hash(data)
+            item.chunks.append(cache.add_chunk(id_, Chunk(data, **chunk_kw), stats))
             if self.show_progress:
                 self.stats.show_progress(item=item, dt=0.2)
             if self.checkpoint_interval and time.time() - self.last_checkpoint > self.checkpoint_interval:
@@ -815,7 +850,8 @@ Number of files: {0.stats.nfiles}'''.format(
         is_special_file = is_special(st.st_mode)
         if not is_special_file:
             path_hash = self.key.id_hash(safe_encode(os.path.join(self.cwd, path)))
-            ids = cache.file_known_and_unchanged(path_hash, st, ignore_inode)
+            with timings.timer('files_cache'):
+                ids = cache.file_known_and_unchanged(path_hash, st, ignore_inode)
         else:
             # in --read-special mode, we may be called for special files.
             # there should be no information in the cache about special files processed in
@@ -1336,6 +1372,9 @@ class ArchiveChecker:
                 items_buffer.flush(flush=True)
                 for previous_item_id in archive.items:
                     mark_as_possibly_superseded(previous_item_id)
+                if 'nfiles' in archive and archive.items != items_buffer.chunks:
+                    # the statistics stored at save time do not match the repaired items any more
+                    del archive.nfiles, archive.size, archive.csize
                 archive.items = items_buffer.chunks
                 data = msgpack.packb(archive.as_dict(), unicode_errors='surrogateescape')
                 new_archive_id = self.key.id_hash(data)
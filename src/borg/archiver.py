@@ -51,6 +51,7 @@ from .platform import get_flags
 from .remote import RepositoryServer, RemoteRepository, cache_if_remote
 from .repository import Repository
 from .selftest import selftest
+from .timings import timings
 from .upgrader import AtticRepositoryUpgrader, BorgRepositoryUpgrader
 
 
@@ -360,7 +361,8 @@ class Archiver:
             return
         if st is None:
             try:
-                st = os.lstat(path)
+                with timings.timer('walk'):
+                    st = os.lstat(path)
             except OSError as e:
                 self.print_warning('%s: %s', path, e)
                 return
@@ -401,7 +403,8 @@ class Archiver:
                 status = archive.process_dir(path, st)
             if recurse:
                 try:
-                    entries = helpers.scandir_inorder(path)
+                    with timings.timer('walk'):
+                        entries = helpers.scandir_inorder(path)
                 except OSError as e:
                     status = 'E'
                     self.print_warning('%s: %s', path, e)
@@ -1386,6 +1389,9 @@ class Archiver:
             Use a built-in heuristic to decide per chunk whether to compress or not.
             The heuristic tries with lz4 whether the data is compressible.
             For incompressible data, it will not use compression (uses "none").
+            For data lz4 can only shrink by a few percent, it uses "lz4" (running a
+            more expensive compressor on such data, e.g. media files or archives, is
+            usually just a waste of CPU cycles).
             For compressible data, it uses the given C[,L] compression - with C[,L]
             being any valid compression specifier.
 
@@ -1497,6 +1503,11 @@ class Archiver:
                                   help='show/log the borg version')
         common_group.add_argument('--show-rc', dest='show_rc', action='store_true', default=False,
                                   help='show/log the return code (rc)')
+        common_group.add_argument('--show-timings', dest='show_timings', action='store_true', default=False,
+                                  help='show/log time spent in the stages of the operation (as JSON)')
+        common_group.add_argument('--timings-interval', dest='timings_interval', type=float, metavar='SECONDS',
+                                  default=0,
+                                  help='with --show-timings, also log timings every SECONDS while working')
         common_group.add_argument('--no-files-cache', dest='cache_files', action='store_false',
                                   help='do not load/update the file metadata cache used to detect unchanged files')
         common_group.add_argument('--umask', dest='umask', type=lambda s: int(s, 8), default=UMASK_DEFAULT, metavar='M',
@@ -2598,6 +2609,7 @@ class Archiver:
                 'output_list': 'borg.output.list',
                 'show_version': 'borg.output.show-version',
                 'show_rc': 'borg.output.show-rc',
+                'show_timings': 'borg.output.timings',
                 'stats': 'borg.output.stats',
                 'progress': 'borg.output.progress',
                 }
@@ -2624,6 +2636,13 @@ class Archiver:
         self.prerun_checks(logger)
         if is_slow_msgpack():
             logger.warning("Using a pure-python msgpack! This will result in lower performance.")
+        if args.show_timings:
+            timings.enable(interval=args.timings_interval)
+            try:
+                return args.func(args)
+            finally:
+                timings.emit()
+                timings.disable()
         return args.func(args)
 
 
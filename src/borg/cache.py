@@ -160,6 +160,14 @@ Chunk index:    {0.total_unique_chunks:20d} {0.total_chunks:20d}"""
         with SaveFile(os.path.join(self.path, 'files'), binary=True) as fd:
             pass  # empty file
 
+    def archive_chunk_index(self, archive_id):
+        """Return the chunk index of archive *archive_id* that sync() cached or None if there is none."""
+        path = os.path.join(self.path, 'chunks.archive.d', bin_to_hex(archive_id))
+        if not os.path.isfile(path):
+            # not cached (yet) - e.g. archives created since the last sync()
+            return None
+        return ChunkIndex.read(path.encode('utf-8'))
+
     def _do_open(self):
         self.config = configparser.ConfigParser(interpolation=None)
         config_path = os.path.join(self.path, 'config')
@@ -180,8 +188,39 @@ Chunk index:    {0.total_unique_chunks:20d} {0.total_chunks:20d}"""
         self.key_type = self.config.get('cache', 'key_type', fallback=None)
         self.previous_location = self.config.get('cache', 'previous_location', fallback=None)
         self.chunks = ChunkIndex.read(os.path.join(self.path, 'chunks').encode('utf-8'))
+        self._read_chunks_summary()
         self.files = None
 
+    def _chunks_file_identity(self):
+        # begin_txn() and rollback() copy the chunks file with its mtime, so this survives a rollback.
+        # the mtime might be coarse, so also compare the number of entries.
+        st = os.stat(os.path.join(self.path, 'chunks'))
+        return [st.st_size, st.st_mtime_ns, len(self.chunks)]
+
+    def _read_chunks_summary(self):
+        """Use the chunks index totals saved by _write_chunks_summary(), so summarize() needs no full walk."""
+        try:
+            with open(os.path.join(self.path, 'chunks.summary'), 'rb') as fd:
+                version, identity, summary = msgpack.unpack(fd)
+            # the chunks file might have been written without updating the summary (rollback,
+            # crash, older borg versions), so only use it for exactly the file it was made for.
+            if version == 1 and identity == self._chunks_file_identity():
+                self.chunks.set_summary(summary)
+        except Exception:
+            # missing or damaged - summarize() will compute the totals
+            pass
+
+    def _write_chunks_summary(self):
+        summary = self.chunks.summarize()
+        with SaveFile(os.path.join(self.path, 'chunks.summary'), binary=True) as fd:
+            msgpack.pack((1, self._chunks_file_identity(), summary), fd)
+
+    def _remove_chunks_summary(self):
+        try:
+            os.unlink(os.path.join(self.path, 'chunks.summary'))
+        except FileNotFoundError:
+            pass
+
     def open(self, lock_wait=None):
         if not os.path.isdir(self.path):
             raise Exception('%s Does not look like a Borg cache' % self.path)
@@ -214,7 +253,7 @@ Chunk index:    {0.total_unique_chunks:20d} {0.total_chunks:20d}"""
         txn_dir = os.path.join(self.path, 'txn.tmp')
         os.mkdir(txn_dir)
         shutil.copy(os.path.join(self.path, 'config'), txn_dir)
-        shutil.copy(os.path.join(self.path, 'chunks'), txn_dir)
+        shutil.copy2(os.path.join(self.path, 'chunks'), txn_dir)
         shutil.copy(os.path.join(self.path, 'files'), txn_dir)
         os.rename(os.path.join(self.path, 'txn.tmp'),
                   os.path.join(self.path, 'txn.active'))
@@ -242,7 +281,10 @@ Chunk index:    {0.total_unique_chunks:20d} {0.total_chunks:20d}"""
         self.config.set('cache', 'previous_location', self.repository._location.canonical_path())
         with SaveFile(os.path.join(self.path, 'config')) as fd:
             self.config.write(fd)
+        # a crash while writing must not leave a summary that seems to match the new chunks file
+        self._remove_chunks_summary()
         self.chunks.write(os.path.join(self.path, 'chunks').encode('utf-8'))
+        self._write_chunks_summary()
         os.rename(os.path.join(self.path, 'txn.active'),
                   os.path.join(self.path, 'txn.tmp'))
         shutil.rmtree(os.path.join(self.path, 'txn.tmp'))
@@ -258,7 +300,7 @@ Chunk index:    {0.total_unique_chunks:20d} {0.total_chunks:20d}"""
         txn_dir = os.path.join(self.path, 'txn.active')
         if os.path.exists(txn_dir):
             shutil.copy(os.path.join(txn_dir, 'config'), self.path)
-            shutil.copy(os.path.join(txn_dir, 'chunks'), self.path)
+            shutil.copy2(os.path.join(txn_dir, 'chunks'), self.path)
             shutil.copy(os.path.join(txn_dir, 'files'), self.path)
             os.rename(txn_dir, os.path.join(self.path, 'txn.tmp'))
             if os.path.exists(os.path.join(self.path, 'txn.tmp')):
@@ -8,7 +8,7 @@ from libc.stdint cimport uint32_t, UINT32_MAX, uint64_t
 from libc.errno cimport errno
 from cpython.exc cimport PyErr_SetFromErrnoWithFilename
 
-API_VERSION = 4
+API_VERSION = 6
 
 
 cdef extern from "_hashindex.c":
@@ -30,6 +30,9 @@ cdef extern from "_hashindex.c":
 
     double HASH_MAX_LOAD
 
+    uint64_t hashindex_resize_count
+    uint64_t hashindex_resize_entries
+
 
 cdef _NoDefault = object()
 
@@ -131,6 +134,11 @@ cdef class IndexBase:
         return hashindex_size(self.index)
 
 
+def resize_stats():
+    """Return (number of resizes, number of entries moved by them) of all indexes in this process."""
+    return hashindex_resize_count, hashindex_resize_entries
+
+
 cdef class NSIndex(IndexBase):
 
     value_size = 8
@@ -222,10 +230,21 @@ cdef class ChunkIndex(IndexBase):
     0 by *increasing* it.
 
     Assigning refcounts in this reserved range is an invalid operation and raises AssertionError.
+
+    The totals returned by summarize() are computed by walking all entries on the first call (or
+    given by set_summary()). From then on, they are maintained by all operations that modify the
+    index, so an index nobody asks for totals does not pay for keeping them.
     """
 
+    cdef uint64_t stats_size, stats_csize, stats_unique_size, stats_unique_csize
+    cdef uint64_t stats_unique_chunks, stats_chunks
+    cdef bint stats_valid
+
     value_size = 12
 
+    def __cinit__(self, capacity=0, path=None, key_size=32):
+        self.stats_valid = False
+
     def __getitem__(self, key):
         assert len(key) == self.key_size
         data = <uint32_t *>hashindex_get(self.index, <char *>key)
@@ -243,8 +262,29 @@ cdef class ChunkIndex(IndexBase):
         data[0] = _htole32(refcount)
         data[1] = _htole32(value[1])
         data[2] = _htole32(value[2])
+        cdef uint32_t *old
+        if self.stats_valid:
+            old = <uint32_t *>hashindex_get(self.index, <char *>key)
+            if old:
+                # update in place, so we do not need a second lookup
+                self._stats_remove(old)
+                old[0], old[1], old[2] = data[0], data[1], data[2]
+                self._stats_add(data)
+                return
         if not hashindex_set(self.index, <char *>key, data):
             raise Exception('hashindex_set failed')
+        if self.stats_valid:
+            self._stats_add(data)
+
+    def __delitem__(self, key):
+        assert len(key) == self.key_size
+        cdef uint32_t *data
+        if self.stats_valid:
+            data = <uint32_t *>hashindex_get(self.index, <char *>key)
+            if data:
+                self._stats_remove(data)
+        if not hashindex_delete(self.index, <char *>key):
+            raise Exception('hashindex_delete failed')
 
     def __contains__(self, key):
         assert len(key) == self.key_size
@@ -253,6 +293,10 @@ cdef class ChunkIndex(IndexBase):
             assert data[0] <= _MAX_VALUE
         return data != NULL
 
+    def clear(self):
+        IndexBase.clear(self)
+        self.stats_valid = False
+
     def incref(self, key):
         """Increase refcount for 'key', return (refcount, size, csize)"""
         assert len(key) == self.key_size
@@ -263,6 +307,8 @@ cdef class ChunkIndex(IndexBase):
         assert refcount <= _MAX_VALUE, "invalid reference count"
         if refcount != _MAX_VALUE:
             refcount += 1
+            if self.stats_valid:
+                self._stats_refcount_changed(data, 1)
         data[0] = _htole32(refcount)
         return refcount, _le32toh(data[1]), _le32toh(data[2])
 
@@ -277,6 +323,8 @@ cdef class ChunkIndex(IndexBase):
         assert 0 < refcount <= _MAX_VALUE, "invalid reference count"
         if refcount != _MAX_VALUE:
             refcount -= 1
+            if self.stats_valid:
+                self._stats_refcount_changed(data, -1)
         data[0] = _htole32(refcount)
         return refcount, _le32toh(data[1]), _le32toh(data[2])
 
@@ -293,6 +341,24 @@ cdef class ChunkIndex(IndexBase):
         return iter
 
     def summarize(self):
+        """Return (size, csize, unique_size, unique_csize, unique_chunks, chunks) of all entries."""
+        if not self.stats_valid:
+            self._compute_stats()
+        return (self.stats_size, self.stats_csize, self.stats_unique_size, self.stats_unique_csize,
+                self.stats_unique_chunks, self.stats_chunks)
+
+    def set_summary(self, summary):
+        """
+        Use *summary* as the totals of the current entries instead of computing them.
+
+        *summary* must have been returned by summarize() for exactly the same entries (e.g. before
+        the index was written to disk), otherwise summarize() returns garbage from now on.
+        """
+        (self.stats_size, self.stats_csize, self.stats_unique_size, self.stats_unique_csize,
+         self.stats_unique_chunks, self.stats_chunks) = summary
+        self.stats_valid = True
+
+    cdef _compute_stats(self):
         cdef uint64_t size = 0, csize = 0, unique_size = 0, unique_csize = 0, chunks = 0, unique_chunks = 0
         cdef uint32_t *values
         cdef uint32_t refcount
@@ -312,7 +378,39 @@ cdef class ChunkIndex(IndexBase):
             size += <uint64_t> _le32toh(values[1]) * _le32toh(values[0])
             csize += <uint64_t> _le32toh(values[2]) * _le32toh(values[0])
 
-        return size, csize, unique_size, unique_csize, unique_chunks, chunks
+        self.stats_size, self.stats_csize = size, csize
+        self.stats_unique_size, self.stats_unique_csize = unique_size, unique_csize
+        self.stats_unique_chunks, self.stats_chunks = unique_chunks, chunks
+        self.stats_valid = True
+
+    cdef void _stats_add(self, uint32_t *values):
+        cdef uint64_t refcount = _le32toh(values[0]), size = _le32toh(values[1]), csize = _le32toh(values[2])
+        self.stats_unique_chunks += 1
+        self.stats_chunks += refcount
+        self.stats_unique_size += size
+        self.stats_unique_csize += csize
+        self.stats_size += size * refcount
+        self.stats_csize += csize * refcount
+
+    cdef void _stats_remove(self, uint32_t *values):
+        # the counters are unsigned, but as every removed entry was added before, they never wrap around
+        cdef uint64_t refcount = _le32toh(values[0]), size = _le32toh(values[1]), csize = _le32toh(values[2])
+        self.stats_unique_chunks -= 1
+        self.stats_chunks -= refcount
+        self.stats_unique_size -= size
+        self.stats_unique_csize -= csize
+        self.stats_size -= size * refcount
+        self.stats_csize -= csize * refcount
+
+    cdef void _stats_refcount_changed(self, uint32_t *values, int delta):
+        if delta > 0:
+            self.stats_chunks += 1
+            self.stats_size += _le32toh(values[1])
+            self.stats_csize += _le32toh(values[2])
+        else:
+            self.stats_chunks -= 1
+            self.stats_size -= _le32toh(values[1])
+            self.stats_csize -= _le32toh(values[2])
 
     def add(self, key, refs, size, csize):
         assert len(key) == self.key_size
@@ -330,13 +428,19 @@ cdef class ChunkIndex(IndexBase):
             refcount2 = _le32toh(data[0])
             assert refcount1 <= _MAX_VALUE
             assert refcount2 <= _MAX_VALUE
+            if self.stats_valid:
+                self._stats_remove(values)
             result64 = refcount1 + refcount2
             values[0] = _htole32(min(result64, _MAX_VALUE))
             values[1] = data[1]
             values[2] = data[2]
+            if self.stats_valid:
+                self._stats_add(values)
         else:
             if not hashindex_set(self.index, key, data):
                 raise Exception('hashindex_set failed')
+            if self.stats_valid:
+                self._stats_add(data)
 
     def merge(self, ChunkIndex other):
         cdef void *key = NULL
@@ -39,6 +39,7 @@ from . import crypto
 from . import hashindex
 from . import shellpattern
 from .constants import *  # NOQA
+from .timings import timings
 
 # meta dict, data bytes
 _Chunk = namedtuple('_Chunk', 'meta data')
@@ -85,7 +86,7 @@ class PlaceholderError(Error):
 
 def check_extension_modules():
     from . import platform, compress
-    if hashindex.API_VERSION != 4:
+    if hashindex.API_VERSION != 6:
         raise ExtensionModuleError
     if chunker.API_VERSION != 2:
         raise ExtensionModuleError
@@ -1702,10 +1703,9 @@ class CompressionDecider2:
         self.compression = compression
 
     def decide(self, chunk):
-        # nothing fancy here yet: we either use what the metadata says or the default
-        # later, we can decide based on the chunk data also.
-        # if we compress the data here to decide, we can even update the chunk data
-        # and modify the metadata as desired.
+        # we either use what the metadata says or the default.
+        # for "auto", we compress the data here to decide and update the chunk metadata with the
+        # decision (and the compressed data, if it is usable as is).
         compr_spec = chunk.meta.get('compress', self.compression)
         if compr_spec['name'] == 'auto':
             # we did not decide yet, use heuristic:
@@ -1716,18 +1716,28 @@ class CompressionDecider2:
         from .compress import get_compressor
         meta, data = chunk
         lz4 = get_compressor('lz4')
-        cdata = lz4.compress(data)
+        with timings.timer('compress_estimate', len(data)):
+            cdata = lz4.compress(data)
         data_len = len(data)
         cdata_len = len(cdata)
-        if cdata_len < data_len:
+        ratio = cdata_len / data_len if data_len else 1.0
+        # do not modify compr_args or meta in place, they might be our default or shared chunk metadata.
+        meta = dict(meta)
+        if ratio < AUTO_COMPRESSION_RATIO:
+            # compressible - worth running the (maybe expensive) compressor the user asked for.
             compr_spec = compr_args['spec']
+        elif ratio < 1.0:
+            # lz4 squeezes a bit, but an expensive compressor will likely not pay off.
+            # we already have the lz4 compressed data, see KeyBase.compress.
+            compr_spec = CompressionSpec('lz4')
+            meta['cdata'] = cdata
         else:
             # uncompressible - we could have a special "uncompressible compressor"
             # that marks such data as uncompressible via compression-type metadata.
             compr_spec = CompressionSpec('none')
-        compr_args.update(compr_spec)
+        meta['compress'] = compr_spec
         self.logger.debug("len(data) == %d, len(lz4(data)) == %d, choosing %s", data_len, cdata_len, compr_spec)
-        return compr_args, Chunk(data, **meta)
+        return compr_spec, Chunk(data, **meta)
 
 
 class ErrorIgnoringTextIOWrapper(io.TextIOWrapper):
@@ -229,6 +229,7 @@ class ArchiveItem(PropDict):
     VALID_KEYS = {'version', 'name', 'items', 'cmdline', 'hostname', 'username', 'time', 'time_end',
                   'comment', 'chunker_params',
                   'recreate_cmdline', 'recreate_source_id', 'recreate_args', 'recreate_partial_chunks',
+                  'nfiles', 'size', 'csize',
                   }  # str-typed keys
 
     __slots__ = ("_dict", )  # avoid setting attributes not supported by properties
@@ -247,6 +248,10 @@ class ArchiveItem(PropDict):
     recreate_cmdline = PropDict._make_property('recreate_cmdline', list)  # list of s-e-str
     recreate_args = PropDict._make_property('recreate_args', list)  # list of s-e-str
     recreate_partial_chunks = PropDict._make_property('recreate_partial_chunks', list)  # list of tuples
+    # statistics of the archive, except for the archive metadata chunk itself
+    nfiles = PropDict._make_property('nfiles', int)
+    size = PropDict._make_property('size', int)
+    csize = PropDict._make_property('csize', int)
 
 
 class ManifestItem(PropDict):
@@ -24,6 +24,7 @@ from .helpers import CompressionDecider2, CompressionSpec
 from .item import Key, EncryptedKey
 from .platform import SaveFile
 from .nonces import NonceManager
+from .timings import timings
 
 
 PREFIX = b'\0' * 8
@@ -97,10 +98,17 @@ class KeyBase:
         """
 
     def compress(self, chunk):
+        # the lz4 trial of the auto heuristic is accounted to compress_estimate, see CompressionDecider2
         compr_args, chunk = self.compression_decider2.decide(chunk)
-        compressor = Compressor(**compr_args)
         meta, data = chunk
-        data = compressor.compress(data)
+        with timings.timer('compress', len(data)):
+            if 'cdata' in meta:
+                # the decider already compressed the data the way it decided to
+                meta = dict(meta)
+                data = meta.pop('cdata')
+            else:
+                compressor = Compressor(**compr_args)
+                data = compressor.compress(data)
         return Chunk(data, **meta)
 
     def encrypt(self, chunk):
@@ -144,7 +152,8 @@ class PlaintextKey(KeyBase):
         payload = memoryview(data)[1:]
         if not decompress:
             return Chunk(payload)
-        data = self.compressor.decompress(payload)
+        with timings.timer('decompress', len(payload)):
+            data = self.compressor.decompress(payload)
         self.assert_id(id, data)
         return Chunk(data)
 
@@ -172,9 +181,10 @@ class AESKeyBase(KeyBase):
     def encrypt(self, chunk):
         chunk = self.compress(chunk)
         self.nonce_manager.ensure_reservation(num_aes_blocks(len(chunk.data)))
-        self.enc_cipher.reset()
-        data = b''.join((self.enc_cipher.iv[8:], self.enc_cipher.encrypt(chunk.data)))
-        hmac = hmac_sha256(self.enc_hmac_key, data)
+        with timings.timer('encrypt', len(chunk.data)):
+            self.enc_cipher.reset()
+            data = b''.join((self.enc_cipher.iv[8:], self.enc_cipher.encrypt(chunk.data)))
+            hmac = hmac_sha256(self.enc_hmac_key, data)
         return b''.join((self.TYPE_STR, hmac, data))
 
     def decrypt(self, id, data, decompress=True):
@@ -182,15 +192,17 @@ class AESKeyBase(KeyBase):
             data[0] == PassphraseKey.TYPE and isinstance(self, RepoKey)):
             raise IntegrityError('Chunk %s: Invalid encryption envelope' % bin_to_hex(id))
         data_view = memoryview(data)
-        hmac_given = data_view[1:33]
-        hmac_computed = memoryview(hmac_sha256(self.enc_hmac_key, data_view[33:]))
-        if not compare_digest(hmac_computed, hmac_given):
-            raise IntegrityError('Chunk %s: Encryption envelope checksum mismatch' % bin_to_hex(id))
-        self.dec_cipher.reset(iv=PREFIX + data[33:41])
-        payload = self.dec_cipher.decrypt(data_view[41:])
+        with timings.timer('decrypt', len(data)):
+            hmac_given = data_view[1:33]
+            hmac_computed = memoryview(hmac_sha256(self.enc_hmac_key, data_view[33:]))
+            if not compare_digest(hmac_computed, hmac_given):
+                raise IntegrityError('Chunk %s: Encryption envelope checksum mismatch' % bin_to_hex(id))
+            self.dec_cipher.reset(iv=PREFIX + data[33:41])
+            payload = self.dec_cipher.decrypt(data_view[41:])
         if not decompress:
             return Chunk(payload)
-        data = self.compressor.decompress(payload)
+        with timings.timer('decompress', len(payload)):
+            data = self.compressor.decompress(payload)
         self.assert_id(id, data)
         return Chunk(data)
 
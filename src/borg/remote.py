@@ -19,6 +19,7 @@ from .helpers import sysinfo
 from .helpers import bin_to_hex
 from .helpers import replace_placeholders
 from .repository import Repository
+from .timings import timings
 
 RPC_PROTOCOL_VERSION = 2
 
@@ -394,7 +395,8 @@ This problem will go away as soon as the server has been upgraded to 1.0.7+.
                 w_fds = [self.stdin_fd]
             else:
                 w_fds = []
-            r, w, x = select.select(self.r_fds, w_fds, self.x_fds, 1)
+            with timings.timer('remote_wait'):
+                r, w, x = select.select(self.r_fds, w_fds, self.x_fds, 1)
             if x:
                 raise Exception('FD exception occurred')
             for fd in r:
@@ -3,7 +3,8 @@ import os
 import shutil
 import struct
 from binascii import hexlify, unhexlify
-from collections import defaultdict
+from collections import defaultdict, deque
+from concurrent.futures import ThreadPoolExecutor
 from configparser import ConfigParser
 from datetime import datetime
 from functools import partial
@@ -25,6 +26,7 @@ from .locking import Lock, LockError, LockErrorT
 from .logger import create_logger
 from .lrucache import LRUCache
 from .platform import SaveFile, SyncFile, sync_dir
+from .timings import timings
 
 MAX_OBJECT_SIZE = 20 * 1024 * 1024
 MAGIC = b'BORG_SEG'
@@ -33,6 +35,11 @@ TAG_PUT = 0
 TAG_DELETE = 1
 TAG_COMMIT = 2
 
+# parallel segment scanning (index rebuild / replay): number of threads and read buffer size per thread.
+# reading and crc32 computation release the GIL, so this scales until the disk is saturated.
+SCAN_WORKERS = min(8, os.cpu_count() or 1)
+SCAN_BUFFER_SIZE = 4 * 1024 * 1024
+
 FreeSpace = partial(defaultdict, int)
 
 
@@ -563,16 +570,14 @@ class Repository:
         self.exclusive = None
         self.prepare_txn(index_transaction_id, do_cleanup=False)
         try:
-            segment_count = sum(1 for _ in self.io.segment_iterator())
-            pi = ProgressIndicatorPercent(total=segment_count, msg="Replaying segments %3.0f%%")
-            for i, (segment, filename) in enumerate(self.io.segment_iterator()):
+            segments = [(segment, filename) for segment, filename in self.io.segment_iterator()
+                        if (index_transaction_id is None or segment > index_transaction_id) and
+                        segment <= segments_transaction_id]
+            pi = ProgressIndicatorPercent(total=len(segments), msg="Replaying segments %3.0f%%")
+            # segments are scanned in parallel, but the index is updated strictly in segment order
+            for i, (segment, filename, objects) in enumerate(self.io.scan_segments(segments)):
                 pi.show(i)
-                if index_transaction_id is not None and segment <= index_transaction_id:
-                    continue
-                if segment > segments_transaction_id:
-                    break
-                objects = self.io.iter_objects(segment)
-                self._update_index(segment, objects)
+                self._update_index(segment, objects.result())
             pi.finish()
             self.write_index()
         finally:
@@ -669,15 +674,15 @@ class Repository:
         logger.debug('Segment transaction is    %s', segments_transaction_id)
         logger.debug('Determined transaction is %s', transaction_id)
         self.prepare_txn(None)  # self.index, self.compact, self.segments all empty now!
-        segment_count = sum(1 for _ in self.io.segment_iterator())
-        logger.debug('Found %d segments', segment_count)
-        pi = ProgressIndicatorPercent(total=segment_count, msg="Checking segments %3.1f%%", step=0.1)
-        for i, (segment, filename) in enumerate(self.io.segment_iterator()):
+        segments = list(self.io.segment_iterator())
+        logger.debug('Found %d segments', len(segments))
+        segments = [(segment, filename) for segment, filename in segments if segment <= transaction_id]
+        pi = ProgressIndicatorPercent(total=len(segments), msg="Checking segments %3.1f%%", step=0.1)
+        # segments are scanned in parallel, but the index is updated strictly in segment order
+        for i, (segment, filename, objects) in enumerate(self.io.scan_segments(segments)):
             pi.show(i)
-            if segment > transaction_id:
-                continue
             try:
-                objects = list(self.io.iter_objects(segment))
+                objects = objects.result()
             except IntegrityError as err:
                 report_error(str(err))
                 objects = []
@@ -993,9 +998,11 @@ class LoggedIO:
 
     def close_segment(self):
         if self._write_fd:
+            segment_size = self.offset
             self.segment += 1
             self.offset = 0
-            self._write_fd.close()
+            with timings.timer('segment_sync', segment_size):
+                self._write_fd.close()  # syncs, see SyncFile
             self._write_fd = None
 
     def delete_segment(self, segment):
@@ -1021,7 +1028,16 @@ class LoggedIO:
 
         The iterator returns four-tuples of (tag, key, offset, data|size).
         """
-        fd = self.get_fd(segment)
+        yield from self._iter_entries(lambda: self.get_fd(segment), segment, offset, include_data, read_data)
+
+    def _iter_entries(self, get_fd, segment, offset, include_data, read_data):
+        """
+        Parse the entries of *segment* starting at *offset*, see iter_objects().
+
+        get_fd() is called again after each entry was yielded and must return an open file for the
+        segment - it is seeked to the next entry before reading from it.
+        """
+        fd = get_fd()
         fd.seek(offset)
         if offset == 0:
             # we are touching this segment for the first time, check the MAGIC.
@@ -1045,10 +1061,38 @@ class LoggedIO:
             # different segment(s)).
             # by calling get_fd() here again we also make our fd "recently used" so it likely
             # does not get kicked out of self.fds LRUcache.
-            fd = self.get_fd(segment)
+            fd = get_fd()
             fd.seek(offset)
             header = fd.read(self.header_fmt.size)
 
+    def scan_segments(self, segments, read_data=True, workers=SCAN_WORKERS):
+        """
+        Scan *segments* (an iterable of (segment, filename)) using *workers* threads.
+
+        Yields (segment, filename, objects) in the order of *segments*. objects.result() returns the
+        list iter_objects(segment, read_data=read_data) would yield or raises the IntegrityError it
+        would raise. Up to 2 * *workers* + 1 segments are queued for scanning ahead of the caller.
+        """
+        pending = deque()
+        with ThreadPoolExecutor(max_workers=workers) as executor:
+            try:
+                for segment, filename in segments:
+                    pending.append((segment, filename,
+                                    executor.submit(self._scan_segment, segment, filename, read_data)))
+                    if len(pending) > 2 * workers:
+                        yield pending.popleft()
+                while pending:
+                    yield pending.popleft()
+            finally:
+                # caller stopped early (e.g. an exception), do not scan segments nobody will look at
+                for _, _, objects in pending:
+                    objects.cancel()
+
+    def _scan_segment(self, segment, filename, read_data):
+        """Return list(iter_objects(segment, read_data=read_data)), but thread-safe and using large reads."""
+        with open(filename, 'rb', buffering=SCAN_BUFFER_SIZE) as fd:
+            return list(self._iter_entries(lambda: fd, segment, 0, include_data=False, read_data=read_data))
+
     def recover_segment(self, segment, filename):
         if segment in self.fds:
             del self.fds[segment]
@@ -1147,8 +1191,9 @@ class LoggedIO:
         size = data_size + self.put_header_fmt.size
         offset = self.offset
         header = self.header_no_crc_fmt.pack(size, TAG_PUT)
-        crc = self.crc_fmt.pack(crc32(data, crc32(id, crc32(header))) & 0xffffffff)
-        fd.write(b''.join((crc, header, id, data)))
+        with timings.timer('write_put', size):
+            crc = self.crc_fmt.pack(crc32(data, crc32(id, crc32(header))) & 0xffffffff)
+            fd.write(b''.join((crc, header, id, data)))
         self.offset += size
         return self.segment, offset
 
@@ -1165,7 +1210,8 @@ class LoggedIO:
             # Intermediate commits go directly into the current segment - this makes checking their validity more
             # expensive, but is faster and reduces clobber.
             fd = self.get_write_fd()
-            fd.sync()
+            with timings.timer('segment_sync', self.offset):
+                fd.sync()
         else:
             self.close_segment()
             fd = self.get_write_fd()
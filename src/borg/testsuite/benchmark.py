@@ -4,12 +4,27 @@ Do benchmarks using pytest-benchmark.
 Usage:
 
     py.test --benchmark-only
+
+or, to save the results for comparing builds:
+
+    py.test --benchmark-only --benchmark-json=results.json
 """
 
+import itertools
 import os
+import random
+from binascii import hexlify
+from io import BytesIO
 
 import pytest
 
+from ..chunker import Chunker
+from ..compress import Compressor
+from ..constants import CHUNKER_PARAMS, ITEMS_CHUNKER_PARAMS
+from ..crypto import AES, hmac_sha256
+from ..hashindex import ChunkIndex
+from ..helpers import Chunk, CompressionSpec, CompressionDecider2, consume
+from ..repository import Repository
 from .archiver import changedir, cmd
 
 
@@ -31,7 +46,7 @@ def repo(request, cmd, repo_url):
     return repo_url
 
 
-@pytest.yield_fixture(scope='session', params=["zeros", "random"])
+@pytest.yield_fixture(scope='session', params=["zeros", "random", "mixed"])
 def testdata(request, tmpdir_factory):
     count, size = 10, 1000*1000
     p = tmpdir_factory.mktemp('data')
@@ -43,6 +58,14 @@ def testdata(request, tmpdir_factory):
     if data_type == 'random':
         def data(size):
             return os.urandom(size)
+    if data_type == 'mixed':
+        # alternating compressible and incompressible files, like a typical mix of text and media.
+        # mixing blocks within a file would not do: chunks are >= 512 KiB, so every chunk would
+        # get about the same compression ratio.
+        kinds = itertools.cycle([lambda size: b'0' * size, os.urandom])
+
+        def data(size):
+            return next(kinds)(size)
     for i in range(count):
         with open(str(p.join(str(i))), "wb") as f:
             f.write(data(size))
@@ -67,6 +90,11 @@ def test_create_lz4(benchmark, cmd, repo, testdata):
     assert result == 0
 
 
+def test_create_auto_lzma(benchmark, cmd, repo, testdata):
+    result, out = benchmark.pedantic(cmd, ('create', '--compression', 'auto,lzma', repo + '::test', testdata))
+    assert result == 0
+
+
 def test_extract(benchmark, cmd, archive, tmpdir):
     with changedir(str(tmpdir)):
         result, out = benchmark.pedantic(cmd, ('extract', archive))
@@ -97,3 +125,217 @@ def test_check(benchmark, cmd, archive):
 def test_help(benchmark, cmd):
     result, out = benchmark(cmd, 'help')
     assert result == 0
+
+
+# Microbenchmarks of the kernels used by the commands above.
+#
+# Sizes can be scaled up via environment variables, e.g. to see how the hashindex behaves at
+# production scale: BORG_BENCHMARK_INDEX_ENTRIES=1000000,100000000 py.test --benchmark-only -k hashindex
+#
+# Use --benchmark-json=FILE to get machine-readable results, e.g. for comparing builds.
+# The amount of data processed per round is recorded in extra_info['bytes'].
+
+def env_sizes(name, default):
+    return [int(s) for s in os.environ.get(name, default).split(',')]
+
+
+INDEX_ENTRIES = env_sizes('BORG_BENCHMARK_INDEX_ENTRIES', '1000000')
+INDEX_LOAD_FACTORS = [0.25, 0.5, 0.75]
+CHUNK_SIZES = env_sizes('BORG_BENCHMARK_CHUNK_SIZES', '1024,65536,1048576,8388608')
+DATA_SIZE = 16 * 1024 * 1024
+
+
+def random_keys(count):
+    data = os.urandom(32 * count)
+    return [data[i:i + 32] for i in range(0, 32 * count, 32)]
+
+
+@pytest.fixture(scope='module', params=INDEX_ENTRIES)
+def index_keys(request):
+    return random_keys(request.param)
+
+
+# sizeof(HashHeader) in _hashindex.c
+HASHINDEX_HEADER_SIZE = 18
+
+
+def index_buckets(idx):
+    return (idx.size() - HASHINDEX_HEADER_SIZE) // (32 + ChunkIndex.value_size)
+
+
+def fill_chunk_index(capacity, keys):
+    idx = ChunkIndex(capacity)
+    for key in keys:
+        idx[key] = 1, 1000, 100
+    return idx
+
+
+def make_chunk_index(keys, load_factor):
+    """
+    return a ChunkIndex at *load_factor* and the keys in it.
+
+    The hashindex rounds the capacity up to the next of its table sizes, so the number of entries
+    is adapted to the real table size: it is about len(keys), with more random keys if needed.
+    """
+    buckets = index_buckets(ChunkIndex(int(len(keys) / load_factor)))
+    count = int(buckets * load_factor)
+    keys = keys[:count] + random_keys(max(0, count - len(keys)))
+    return fill_chunk_index(buckets, keys), keys
+
+
+def record_index(benchmark, idx):
+    benchmark.extra_info['entries'] = len(idx)
+    benchmark.extra_info['load_factor'] = round(len(idx) / index_buckets(idx), 3)
+
+
+def test_hashindex_insert(benchmark, index_keys):
+    # no capacity given, so this includes all resizes while growing the index
+    def insert(keys):
+        idx = ChunkIndex()
+        for key in keys:
+            idx[key] = 1, 1000, 100
+    benchmark.extra_info['entries'] = len(index_keys)
+    benchmark.pedantic(insert, (index_keys, ), rounds=3)
+
+
+@pytest.mark.parametrize('load_factor', INDEX_LOAD_FACTORS)
+def test_hashindex_lookup(benchmark, index_keys, load_factor):
+    idx, keys = make_chunk_index(index_keys, load_factor)
+    missing_keys = random_keys(len(keys))
+
+    def lookup():
+        for key in keys:
+            idx[key]
+        for key in missing_keys:
+            key in idx
+    record_index(benchmark, idx)
+    benchmark.pedantic(lookup, rounds=3)
+
+
+@pytest.mark.parametrize('load_factor', INDEX_LOAD_FACTORS)
+def test_hashindex_delete(benchmark, index_keys, load_factor):
+    # deleting all entries also includes the resizes while shrinking the index
+    idx, keys = make_chunk_index(index_keys, load_factor)
+    buckets = index_buckets(idx)
+
+    def delete(idx):
+        for key in keys:
+            del idx[key]
+    record_index(benchmark, idx)
+    benchmark.pedantic(delete, setup=lambda: ((fill_chunk_index(buckets, keys), ), {}), rounds=3)
+
+
+def test_hashindex_merge(benchmark, index_keys):
+    # this is what the cache sync does with the chunk indexes of all archives
+    half = len(index_keys) // 2
+    other, _ = make_chunk_index(index_keys[half:], ChunkIndex.MAX_LOAD_FACTOR)
+    idx, keys = make_chunk_index(index_keys[:half + half // 2], ChunkIndex.MAX_LOAD_FACTOR)
+    buckets = index_buckets(idx)
+    record_index(benchmark, idx)
+    benchmark.pedantic(lambda idx: idx.merge(other),
+                       setup=lambda: ((fill_chunk_index(buckets, keys), ), {}),
+                       rounds=3)
+
+
+@pytest.fixture(scope='module', params=['zeros', 'random', 'text'])
+def entropy_data(request):
+    if request.param == 'zeros':
+        return b'0' * DATA_SIZE
+    if request.param == 'random':
+        return os.urandom(DATA_SIZE)
+    if request.param == 'text':
+        # low entropy, but not trivially compressible
+        words = [hexlify(os.urandom(4)) for _ in range(1000)]
+        rnd = random.Random(0)
+        return b' '.join(rnd.choice(words) for _ in range(DATA_SIZE // 8))[:DATA_SIZE]
+
+
+@pytest.mark.parametrize('chunker_params', [CHUNKER_PARAMS, ITEMS_CHUNKER_PARAMS, (10, 23, 16, 4095)],
+                         ids=lambda params: ','.join(str(p) for p in params))
+def test_chunker(benchmark, entropy_data, chunker_params):
+    chunker = Chunker(0, *chunker_params)
+    benchmark.extra_info['bytes'] = len(entropy_data)
+    benchmark(lambda: consume(chunker.chunkify(BytesIO(entropy_data))))
+
+
+@pytest.mark.parametrize('spec', ['none', 'lz4', 'zlib,1', 'zlib,6', 'lzma,0', 'lzma,6', 'auto,zlib,6', 'auto,lzma,6'])
+def test_compress(benchmark, entropy_data, spec):
+    compr_spec = CompressionSpec(spec)
+    data = entropy_data[:1024 * 1024]
+    decider = CompressionDecider2(compr_spec)
+
+    def compress():
+        compr_args, chunk = decider.decide(Chunk(data))
+        return Compressor(**compr_args).compress(chunk.data)
+    benchmark.extra_info['bytes'] = len(data)
+    benchmark.extra_info['compressed_bytes'] = len(compress())
+    benchmark(compress)
+
+
+@pytest.mark.parametrize('spec', ['none', 'lz4', 'zlib,6', 'lzma,6'])
+def test_decompress(benchmark, entropy_data, spec):
+    data = entropy_data[:1024 * 1024]
+    cdata = Compressor(**CompressionSpec(spec)).compress(data)
+    compressor = Compressor('none')
+    benchmark.extra_info['bytes'] = len(data)
+    benchmark(compressor.decompress, cdata)
+
+
+@pytest.mark.parametrize('size', CHUNK_SIZES)
+def test_aes_encrypt(benchmark, size):
+    data = os.urandom(size)
+    aes = AES(is_encrypt=True, key=os.urandom(32))
+
+    def encrypt():
+        aes.reset()
+        return aes.encrypt(data)
+    benchmark.extra_info['bytes'] = size
+    benchmark(encrypt)
+
+
+@pytest.mark.parametrize('size', CHUNK_SIZES)
+def test_hmac_sha256(benchmark, size):
+    data = os.urandom(size)
+    key = os.urandom(32)
+    benchmark.extra_info['bytes'] = size
+    benchmark(hmac_sha256, key, data)
+
+
+# Synthetic large repository workloads.
+
+@pytest.yield_fixture(scope='session')
+def testdata_many_files(tmpdir_factory):
+    count, = env_sizes('BORG_BENCHMARK_FILES', '10000')
+    p = tmpdir_factory.mktemp('many_files')
+    for i in range(count):
+        d = p.join(str(i // 1000))
+        d.ensure(dir=True)
+        with open(str(d.join(str(i))), 'wb') as f:
+            f.write(os.urandom(1000))
+    yield str(p)
+    p.remove(rec=1)
+
+
+def test_create_many_files(benchmark, cmd, repo, testdata_many_files):
+    result, out = benchmark.pedantic(cmd, ('create', repo + '::test', testdata_many_files))
+    assert result == 0
+
+
+def test_repository_put_many(benchmark, tmpdir):
+    count, = env_sizes('BORG_BENCHMARK_OBJECTS', '100000')
+    keys = random_keys(count)
+    data = os.urandom(1000)
+
+    def put_many(repository):
+        with repository:
+            for key in keys:
+                repository.put(key, data)
+            repository.commit()
+
+    def setup():
+        path = tmpdir.join('repository')
+        if path.exists():
+            path.remove(rec=1)
+        return (Repository(str(path), exclusive=True, create=True), ), {}
+    benchmark.extra_info['objects'] = count
+    benchmark.pedantic(put_many, setup=setup, rounds=3)
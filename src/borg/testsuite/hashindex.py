@@ -124,6 +124,40 @@ class HashIndexTestCase(BaseTestCase):
         assert chunks == 1 + 2 + 3
         assert unique_chunks == 3
 
+    def test_chunkindex_summarize_incremental(self):
+        idx = ChunkIndex()
+        for x in range(100):
+            idx[H(x)] = x + 1, x * 100, x * 10
+        # the first summarize() computes the totals, from then on they are maintained incrementally
+        idx.summarize()
+        for x in range(0, 100, 3):
+            idx.incref(H(x))
+        for x in range(0, 100, 5):
+            idx.decref(H(x))
+        for x in range(0, 100, 7):
+            del idx[H(x)]
+        idx[H(1)] = 7, 123, 45
+        idx[H(4000)] = 1, 400, 40
+        idx.add(H(2), 3, 200, 20)
+        idx.add(H(1000), 1, 1000, 100)
+        other = ChunkIndex()
+        other[H(3)] = 2, 300, 30
+        other[H(2000)] = 2, 2000, 200
+        idx.merge(other)
+        with tempfile.NamedTemporaryFile() as file:
+            idx.write(file.name)
+            # an index read from disk computes the totals from all entries
+            assert ChunkIndex.read(file.name).summarize() == idx.summarize()
+            # ... unless they are given
+            idx2 = ChunkIndex.read(file.name)
+            idx2.set_summary(idx.summarize())
+        for i in idx, idx2:
+            i.incref(H(1))
+            i[H(5000)] = 2, 500, 50
+        assert idx2.summarize() == idx.summarize()
+        idx.clear()
+        assert idx.summarize() == (0, 0, 0, 0, 0, 0)
+
 
 class HashIndexSizeTestCase(BaseTestCase):
     def test_size_on_disk(self):
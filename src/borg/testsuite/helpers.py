@@ -10,6 +10,7 @@ import msgpack
 import msgpack.fallback
 
 from .. import platform
+from ..compress import Compressor
 from ..helpers import Location
 from ..helpers import Buffer
 from ..helpers import partial_format, format_file_size, parse_file_size, format_timedelta, format_line, PlaceholderError, replace_placeholders
@@ -1053,6 +1054,40 @@ def test_compression_decider2():
     assert compr_spec['name'] == 'lzma'
 
 
+def test_compression_decider2_auto():
+    default = CompressionSpec('auto,lzma')
+
+    cd = CompressionDecider2(default)
+    compr_spec, chunk = cd.decide(Chunk(b'0' * 10000))
+    assert compr_spec['name'] == 'lzma'
+    compr_spec, chunk = cd.decide(Chunk(os.urandom(10000)))
+    assert compr_spec['name'] == 'none'
+    # the default spec must not get modified by a decision
+    assert cd.compression['name'] == 'auto'
+    compr_spec, chunk = cd.decide(Chunk(b'0' * 10000))
+    assert compr_spec['name'] == 'lzma'
+    # barely compressible: lz4 shrinks it by about 1%, the lz4 compressed data gets reused
+    data = os.urandom(9800) + b'0' * 200
+    compr_spec, chunk = cd.decide(Chunk(data))
+    assert compr_spec['name'] == 'lz4'
+    assert chunk.data == data
+    assert Compressor(**compr_spec).decompress(chunk.meta['cdata']) == data
+    # the decision is stored in the chunk metadata, deciding again does not run the heuristic again
+    assert cd.decide(chunk) == (compr_spec, chunk)
+
+
+def test_compression_decider2_auto_spec():
+    cd = CompressionDecider2(CompressionSpec('auto,zlib,9'))
+    for data, name in ((b'0' * 10000, 'zlib'), (os.urandom(9800) + b'0' * 200, 'lz4'), (os.urandom(10000), 'none')):
+        compr_spec, chunk = cd.decide(Chunk(data))
+        assert compr_spec['name'] == name
+        # no keys of the auto spec (like "spec" or "level") leak into the decision
+        assert 'spec' not in compr_spec
+        assert ('level' in compr_spec) == (name == 'zlib')
+        assert Compressor(**compr_spec).decompress(Compressor(**compr_spec).compress(data)) == data
+    assert cd.compression == CompressionSpec('auto,zlib,9')
+
+
 def test_format_line():
     data = dict(foo='bar baz')
     assert format_line('', data) == ''
@@ -6,12 +6,15 @@ from binascii import hexlify, unhexlify
 
 import pytest
 
+from ..compress import Compressor
 from ..crypto import bytes_to_long, num_aes_blocks
 from ..helpers import Location
 from ..helpers import Chunk
+from ..helpers import CompressionSpec, CompressionDecider2
 from ..helpers import IntegrityError
 from ..helpers import get_nonces_dir
 from ..key import PlaintextKey, PassphraseKey, KeyfileKey, Passphrase, PasswordRetriesExceeded, bin_to_hex
+from ..timings import timings
 
 
 class TestKey:
@@ -67,6 +70,25 @@ class TestKey:
         assert hexlify(key.id_hash(chunk.data)) == b'2c26b46b68ffc68ff99b453c1d30413413422d706483bfa0f98a5e886266e7ae'
         assert chunk == key.decrypt(key.id_hash(chunk.data), key.encrypt(chunk))
 
+    def test_plaintext_auto_compression(self):
+        key = PlaintextKey.create(None, None)
+        key.compression_decider2 = CompressionDecider2(CompressionSpec('auto,lzma'))
+        # barely compressible data gets stored as compressed by the lz4 heuristic
+        data = os.urandom(9800) + b'0' * 200
+        timings.enable()
+        try:
+            cdata = key.encrypt(Chunk(data))
+            stages = timings.as_dict()['stages']
+        finally:
+            timings.disable()
+        assert Compressor.detect(cdata[1:]).name == 'lz4'
+        # the lz4 trial and the reuse of its result are both accounted
+        assert stages['compress_estimate']['calls'] == 1
+        assert stages['compress_estimate']['bytes'] == len(data)
+        assert stages['compress']['calls'] == 1
+        assert stages['compress']['bytes'] == len(data)
+        assert key.decrypt(key.id_hash(data), cdata).data == data
+
     def test_keyfile(self, monkeypatch, keys_dir):
         monkeypatch.setenv('BORG_PASSPHRASE', 'test')
         key = KeyfileKey.create(self.MockRepository(), self.MockArgs())
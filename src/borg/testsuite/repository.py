@@ -284,6 +284,27 @@ class RepositoryCommitTestCase(RepositoryTestCaseBase):
             self.assert_equal(self.repository.check(), True)
             self.assert_equal(len(self.repository), 3)
 
+    def test_scan_segments(self):
+        for x in range(20):
+            self.repository.put(H(x), b'data' * x)
+            if x % 3 == 0:
+                self.repository.delete(H(x))
+            self.repository.commit()
+        io = self.repository.io
+        segments = list(io.segment_iterator())
+        scanned = list(io.scan_segments(segments, workers=2))
+        assert [(segment, filename) for segment, filename, _ in scanned] == segments
+        for segment, filename, objects in scanned:
+            assert objects.result() == list(io.iter_objects(segment))
+        assert [objects.result() for _, _, objects in io.scan_segments(segments, read_data=False, workers=2)] == \
+               [list(io.iter_objects(segment, read_data=False)) for segment, _ in segments]
+        segment, filename = segments[-1]
+        with open(filename, 'r+b') as fd:
+            fd.write(b'BOOM')
+        with pytest.raises(IntegrityError):
+            for _, _, objects in io.scan_segments(segments, workers=2):
+                objects.result()
+
     def test_ignores_commit_tag_in_data(self):
         self.repository.put(H(0), LoggedIO.COMMIT)
         self.reopen()
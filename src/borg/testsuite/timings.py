@@ -0,0 +1,48 @@
+from ..hashindex import ChunkIndex
+from ..timings import Timings, NULL_TIMER
+
+
+class TestTimings:
+
+    def test_disabled(self):
+        t = Timings()
+        assert t.timer('stage', 100) is NULL_TIMER
+        with t.timer('stage', 100):
+            pass
+        t.add('stage', 1.0, 100)
+        assert list(t.timed_iter('iter', [b'a', b'bc'])) == [b'a', b'bc']
+        assert t.stages == {}
+
+    def test_enabled(self):
+        t = Timings()
+        t.enable()
+        with t.timer('stage', 100):
+            pass
+        with t.timer('stage', 50):
+            pass
+        t.add('other', 0.5)
+        assert list(t.timed_iter('iter', [b'a', b'bc'])) == [b'a', b'bc']
+        stages = t.as_dict()['stages']
+        assert stages['stage']['calls'] == 2
+        assert stages['stage']['bytes'] == 150
+        assert stages['other'] == dict(calls=1, bytes=0, seconds=0.5)
+        assert stages['iter']['calls'] == 2
+        assert stages['iter']['bytes'] == 3
+        t.disable()
+        assert t.stages == {}
+        assert t.timer('stage') is NULL_TIMER
+
+    def test_hashindex_resizes(self):
+        def grow_index():
+            idx = ChunkIndex()
+            for i in range(1000):
+                idx[i.to_bytes(32, 'little')] = (1, 1, 1)
+
+        grow_index()  # resizes before enable() are not reported
+        t = Timings()
+        t.enable()
+        assert t.as_dict()['hashindex'] == dict(resizes=0, resized_entries=0)
+        grow_index()
+        hashindex = t.as_dict()['hashindex']
+        assert hashindex['resizes'] > 0
+        assert hashindex['resized_entries'] > 0
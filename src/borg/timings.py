@@ -0,0 +1,141 @@
+"""
+Low-overhead per-stage timers and counters (see --show-timings).
+
+Code in hot paths wraps the work of a stage like this::
+
+    with timings.timer('compress', len(data)):
+        data = compressor.compress(data)
+
+As long as timings are not enabled, timer() returns a shared no-op context manager,
+so the cost of an instrumented stage is one method call and one attribute lookup.
+"""
+
+import json
+import time
+
+from .hashindex import resize_stats
+from .logger import create_logger
+
+logger = create_logger('borg.output.timings')
+
+
+class Stage:
+    __slots__ = ('calls', 'bytes', 'seconds')
+
+    def __init__(self):
+        self.calls = 0
+        self.bytes = 0
+        self.seconds = 0.0
+
+    def as_dict(self):
+        return dict(calls=self.calls, bytes=self.bytes, seconds=round(self.seconds, 6))
+
+
+class Timer:
+    __slots__ = ('timings', 'stage', 'nbytes', 'start')
+
+    def __init__(self, timings, stage, nbytes):
+        self.timings = timings
+        self.stage = stage
+        self.nbytes = nbytes
+
+    def __enter__(self):
+        self.start = time.perf_counter()
+        return self
+
+    def __exit__(self, *exc):
+        self.timings.add(self.stage, time.perf_counter() - self.start, self.nbytes)
+
+
+class NullTimer:
+    __slots__ = ()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        pass
+
+
+NULL_TIMER = NullTimer()
+
+
+class Timings:
+    """
+    Collects time, call and byte counts per named stage and reports them as JSON.
+
+    All stages of a process share the module-level :data:`timings` instance.
+    """
+    def __init__(self):
+        self.enabled = False
+        self.interval = 0
+        self.stages = {}
+        self.start = self.last_emit = None
+        self.resize_base = (0, 0)
+
+    def enable(self, interval=0):
+        """start collecting, emit a report every *interval* seconds (0: only when emit() is called)"""
+        self.enabled = True
+        self.interval = interval
+        self.start = self.last_emit = time.monotonic()
+        # the hashindex resize counters are process-global, only report what happened since now
+        self.resize_base = resize_stats()
+
+    def disable(self):
+        """stop collecting and forget everything collected so far"""
+        self.enabled = False
+        self.stages = {}
+        self.start = self.last_emit = None
+
+    def timer(self, stage, nbytes=0):
+        """return a context manager that accounts the time spent in its block to *stage*"""
+        if not self.enabled:
+            return NULL_TIMER
+        return Timer(self, stage, nbytes)
+
+    def timed_iter(self, stage, iterable):
+        """yield from *iterable*, accounting the time spent in each next() call and the yielded bytes to *stage*"""
+        if not self.enabled:
+            yield from iterable
+            return
+        iterator = iter(iterable)
+        while True:
+            start = time.perf_counter()
+            try:
+                data = next(iterator)
+            except StopIteration:
+                return
+            self.add(stage, time.perf_counter() - start, len(data))
+            yield data
+
+    def add(self, stage, seconds, nbytes=0, calls=1):
+        if not self.enabled:
+            return
+        try:
+            s = self.stages[stage]
+        except KeyError:
+            s = self.stages[stage] = Stage()
+        s.calls += calls
+        s.bytes += nbytes
+        s.seconds += seconds
+        if self.interval and time.monotonic() - self.last_emit >= self.interval:
+            self.emit(final=False)
+
+    def as_dict(self):
+        resizes, resized_entries = (now - base for now, base in zip(resize_stats(), self.resize_base))
+        return {
+            'elapsed': round(time.monotonic() - self.start, 6) if self.start is not None else 0.0,
+            'stages': {name: stage.as_dict() for name, stage in sorted(self.stages.items())},
+            'hashindex': {'resizes': resizes, 'resized_entries': resized_entries},
+        }
+
+    def emit(self, final=True):
+        if not self.enabled:
+            return
+        self.last_emit = time.monotonic()
+        report = self.as_dict()
+        report['final'] = final
+        logger.info(json.dumps(report, sort_keys=True))
+
+
+timings = Timings()